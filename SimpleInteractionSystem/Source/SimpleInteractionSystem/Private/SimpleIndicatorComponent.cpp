@@ -0,0 +1,337 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+
+#include "../Public/SimpleIndicatorComponent.h"
+#include "../Public/SimpleIndicatorWidget.h"
+#include "../Public/SimpleTraceComponent.h"
+#include "../Public/SimpleTraceableComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+// Sets default values for this component's properties
+USimpleIndicatorComponent::USimpleIndicatorComponent()
+{
+	// Ticking is only enabled while at least one indicator is visible.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+// Called when the game starts
+void USimpleIndicatorComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BindTraceComponents();
+	if(APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		Pawn->ReceiveControllerChangedDelegate.AddUniqueDynamic(this, &USimpleIndicatorComponent::OnControllerChanged);
+	}
+	FillPool();
+}
+
+// Called when the game ends
+void USimpleIndicatorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for(USimpleTraceComponent* TraceComponent : TraceComponents)
+	{
+		if(TraceComponent)
+		{
+			TraceComponent->OnFocusChangedDel.RemoveDynamic(this, &USimpleIndicatorComponent::OnFocusChanged);
+		}
+	}
+	TraceComponents.Empty();
+
+	if(APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		Pawn->ReceiveControllerChangedDelegate.RemoveDynamic(this, &USimpleIndicatorComponent::OnControllerChanged);
+	}
+	ResetPool();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Called every frame while an indicator is visible
+void USimpleIndicatorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	for(int32 Index = ActiveIndicators.Num() - 1; Index >= 0; --Index)
+	{
+		if(!UpdateIndicator(ActiveIndicators[Index]))
+		{
+			ReleaseIndicator(Index);
+		}
+	}
+	SetComponentTickEnabled(ActiveIndicators.Num() > 0);
+}
+
+/**
+ * @brief Subscribes to the focus edges of every SimpleTraceComponent on the owner.
+ */
+void USimpleIndicatorComponent::BindTraceComponents()
+{
+	GetOwner()->GetComponents<USimpleTraceComponent>(TraceComponents);
+	for(USimpleTraceComponent* TraceComponent : TraceComponents)
+	{
+		TraceComponent->OnFocusChangedDel.AddUniqueDynamic(this, &USimpleIndicatorComponent::OnFocusChanged);
+	}
+
+	if(TraceComponents.Num() == 0)
+	{
+		UE_LOG(LogSimpleInteractionSystem, Warning, TEXT("'%s' The owner does not contain a SimpleTraceComponent. Indicators will not be shown."), *GetNameSafe(this));
+	}
+}
+
+/**
+ * @brief Creates the pooled indicator widgets up front.
+ *
+ * If the owner is not possessed yet the pool is filled lazily the first time an indicator is needed.
+ */
+void USimpleIndicatorComponent::FillPool()
+{
+	if(!IndicatorWidgetClass)
+	{
+		UE_LOG(LogSimpleInteractionSystem, Error, TEXT("'%s' IndicatorWidgetClass is not set. Indicators will not be shown."), *GetNameSafe(this));
+		return;
+	}
+
+	PoolController = GetOwningPlayerController();
+	while(FreeIndicators.Num() + ActiveIndicators.Num() < PoolSize)
+	{
+		USimpleIndicatorWidget* Indicator = CreateIndicator();
+		if(!Indicator)
+		{
+			return;
+		}
+		FreeIndicators.Add(Indicator);
+	}
+}
+
+/**
+ * @brief Removes every indicator widget from the screen and empties the pool.
+ */
+void USimpleIndicatorComponent::ResetPool()
+{
+	for(USimpleIndicatorWidget* Indicator : ActiveIndicators)
+	{
+		Indicator->RemoveFromParent();
+	}
+	for(USimpleIndicatorWidget* Indicator : FreeIndicators)
+	{
+		Indicator->RemoveFromParent();
+	}
+	ActiveIndicators.Empty();
+	FreeIndicators.Empty();
+	PoolController = nullptr;
+}
+
+/**
+ * @brief Recreates the pool for the current player controller and shows indicators for whatever is focused.
+ */
+void USimpleIndicatorComponent::RebuildPool()
+{
+	ResetPool();
+	if(IndicatorWidgetClass)
+	{
+		FillPool();
+	}
+	PoolController = GetOwningPlayerController();
+
+	for(const USimpleTraceComponent* TraceComponent : TraceComponents)
+	{
+		if(USimpleTraceableComponent* FocusedComponent = TraceComponent ? TraceComponent->GetFocusedComponent() : nullptr)
+		{
+			ShowIndicator(FocusedComponent);
+		}
+	}
+	SetComponentTickEnabled(ActiveIndicators.Num() > 0);
+}
+
+/**
+ * @brief Widgets belong to the controller they were created for, so the pool is rebuilt on possession changes.
+ */
+void USimpleIndicatorComponent::OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	RebuildPool();
+}
+
+/**
+ * @brief Shows or hides indicators on focus edges only.
+ *
+ * @param PreviousFocus The traceable component that lost focus, if any.
+ * @param NewFocus The traceable component that gained focus, if any.
+ */
+void USimpleIndicatorComponent::OnFocusChanged(USimpleTraceableComponent* PreviousFocus, USimpleTraceableComponent* NewFocus)
+{
+	if(PreviousFocus)
+	{
+		HideIndicator(PreviousFocus);
+	}
+	if(NewFocus)
+	{
+		ShowIndicator(NewFocus);
+	}
+	SetComponentTickEnabled(ActiveIndicators.Num() > 0);
+}
+
+/**
+ * @brief Takes an indicator from the pool and binds it to the target.
+ *
+ * Does nothing if the target already has an indicator, e.g. when two trace components focus the same object.
+ *
+ * @param Target The traceable component that gained focus.
+ */
+void USimpleIndicatorComponent::ShowIndicator(USimpleTraceableComponent* Target)
+{
+	if(GetOwningPlayerController() != PoolController)
+	{
+		RebuildPool();
+	}
+
+	for(const USimpleIndicatorWidget* Indicator : ActiveIndicators)
+	{
+		if(Indicator->GetTarget() == Target)
+		{
+			return;
+		}
+	}
+
+	if(USimpleIndicatorWidget* Indicator = AcquireIndicator())
+	{
+		Indicator->ShowForTarget(Target);
+		ActiveIndicators.Add(Indicator);
+		if(!UpdateIndicator(Indicator))
+		{
+			ReleaseIndicator(ActiveIndicators.Num() - 1);
+		}
+	}
+}
+
+/**
+ * @brief Returns the target's indicator to the pool unless another trace component still focuses it.
+ *
+ * @param Target The traceable component that lost focus.
+ */
+void USimpleIndicatorComponent::HideIndicator(USimpleTraceableComponent* Target)
+{
+	if(IsFocusedByAnyTraceComponent(Target))
+	{
+		return;
+	}
+
+	for(int32 Index = 0; Index < ActiveIndicators.Num(); ++Index)
+	{
+		if(ActiveIndicators[Index]->GetTarget() == Target)
+		{
+			ReleaseIndicator(Index);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Hides an active indicator and returns it to the pool.
+ *
+ * @param Index The index of the indicator in ActiveIndicators.
+ */
+void USimpleIndicatorComponent::ReleaseIndicator(int32 Index)
+{
+	USimpleIndicatorWidget* Indicator = ActiveIndicators[Index];
+	Indicator->HideIndicator();
+	ActiveIndicators.RemoveAtSwap(Index);
+	FreeIndicators.Add(Indicator);
+}
+
+/**
+ * @brief Projects the target location and moves the indicator only if it changed beyond PixelThreshold.
+ *
+ * Visibility is toggled only when the target enters or leaves the screen.
+ *
+ * @param Indicator The active indicator to update.
+ * @return False if the target was destroyed or the owner lost its player controller and the indicator should be released.
+ */
+bool USimpleIndicatorComponent::UpdateIndicator(USimpleIndicatorWidget* Indicator) const
+{
+	const USimpleTraceableComponent* Target = Indicator->GetTarget();
+	if(!IsValid(Target) || !IsValid(Target->GetOwner()))
+	{
+		return false;
+	}
+
+	APlayerController* PlayerController = GetOwningPlayerController();
+	if(!PlayerController || PlayerController != PoolController)
+	{
+		return false;
+	}
+
+	FVector2D ScreenPosition;
+	const bool bOnScreen = PlayerController->ProjectWorldLocationToScreen(Target->GetOwner()->GetActorLocation() + IndicatorOffset, ScreenPosition, true);
+	if(bOnScreen)
+	{
+		Indicator->UpdateScreenPosition(ScreenPosition, PixelThreshold);
+	}
+	Indicator->SetOnScreen(bOnScreen);
+	return true;
+}
+
+/**
+ * @return True if any bound trace component currently focuses the target.
+ */
+bool USimpleIndicatorComponent::IsFocusedByAnyTraceComponent(const USimpleTraceableComponent* Target) const
+{
+	for(const USimpleTraceComponent* TraceComponent : TraceComponents)
+	{
+		if(TraceComponent && TraceComponent->GetFocusedComponent() == Target)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @return A free pooled indicator, creating one if the pool is exhausted.
+ */
+USimpleIndicatorWidget* USimpleIndicatorComponent::AcquireIndicator()
+{
+	if(FreeIndicators.Num() > 0)
+	{
+		return FreeIndicators.Pop(EAllowShrinking::No);
+	}
+	return IndicatorWidgetClass ? CreateIndicator() : nullptr;
+}
+
+/**
+ * @return A new collapsed indicator added to the owning player's screen, or nullptr if there is no player controller yet.
+ */
+USimpleIndicatorWidget* USimpleIndicatorComponent::CreateIndicator() const
+{
+	APlayerController* PlayerController = GetOwningPlayerController();
+	if(!PlayerController || !PlayerController->IsLocalController())
+	{
+		return nullptr;
+	}
+
+	USimpleIndicatorWidget* Indicator = CreateWidget<USimpleIndicatorWidget>(PlayerController, IndicatorWidgetClass);
+	if(Indicator)
+	{
+		Indicator->SetVisibility(ESlateVisibility::Collapsed);
+		Indicator->SetAlignmentInViewport(FVector2D(0.5, 0.5));
+		Indicator->AddToPlayerScreen(ZOrder);
+	}
+	return Indicator;
+}
+
+/**
+ * @return The player controller of the owner, whether the owner is a pawn or the controller itself.
+ */
+APlayerController* USimpleIndicatorComponent::GetOwningPlayerController() const
+{
+	if(const APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		return Pawn->GetController<APlayerController>();
+	}
+	return Cast<APlayerController>(GetOwner());
+}
@@ -0,0 +1,92 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+
+#include "../Public/SimpleIndicatorWidget.h"
+#include "../Public/SimpleTraceableComponent.h"
+#include "Widgets/SInvalidationPanel.h"
+
+/**
+ * @brief Binds the indicator to a traceable component and makes it visible.
+ *
+ * The cached screen position is reset so the next UpdateScreenPosition() always places the widget.
+ *
+ * @param InTarget The traceable component the indicator points at.
+ */
+void USimpleIndicatorWidget::ShowForTarget(USimpleTraceableComponent* InTarget)
+{
+	Target = InTarget;
+	bHasScreenPosition = false;
+	bOnScreen = false;
+	OnIndicatorShown(Target);
+}
+
+/**
+ * @brief Collapses the indicator and releases its target.
+ */
+void USimpleIndicatorWidget::HideIndicator()
+{
+	Target = nullptr;
+	bHasScreenPosition = false;
+	SetOnScreen(false);
+	OnIndicatorHidden();
+}
+
+/**
+ * @brief Toggles the widget visibility, touching Slate only when the state actually changes.
+ *
+ * @param bInOnScreen True if the target projects onto the screen.
+ */
+void USimpleIndicatorWidget::SetOnScreen(bool bInOnScreen)
+{
+	if(bOnScreen == bInOnScreen)
+	{
+		return;
+	}
+	bOnScreen = bInOnScreen;
+	SetVisibility(bOnScreen ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+}
+
+/**
+ * @brief Moves the widget in the viewport if the new position differs enough from the last one.
+ *
+ * @param NewScreenPosition The projected position in player viewport pixels.
+ * @param PixelThreshold The minimum distance in pixels before the widget is moved.
+ * @return True if the widget was moved.
+ */
+bool USimpleIndicatorWidget::UpdateScreenPosition(const FVector2D& NewScreenPosition, float PixelThreshold)
+{
+	if(bHasScreenPosition && FVector2D::DistSquared(LastScreenPosition, NewScreenPosition) <= FMath::Square(PixelThreshold))
+	{
+		return false;
+	}
+	LastScreenPosition = NewScreenPosition;
+	bHasScreenPosition = true;
+	SetPositionInViewport(NewScreenPosition, true);
+	return true;
+}
+
+/**
+ * @return The traceable component the indicator currently points at.
+ */
+USimpleTraceableComponent* USimpleIndicatorWidget::GetTarget() const
+{
+	return Target;
+}
+
+/**
+ * @brief Wraps the widget content in an invalidation panel when caching is enabled.
+ *
+ * Moving the widget only changes its viewport slot, so the cached content is not repainted every frame.
+ */
+TSharedRef<SWidget> USimpleIndicatorWidget::RebuildWidget()
+{
+	TSharedRef<SWidget> Content = Super::RebuildWidget();
+	if(!bCacheWidget)
+	{
+		return Content;
+	}
+	return SNew(SInvalidationPanel)
+		[
+			Content
+		];
+}
@@ -1,18 +1,21 @@
 // Copyright 2023 Georgios Lazaridis. All rights reserved.
 
 #include "../Public/SimpleInteractionSystem.h"
+#include "../Public/SimpleInterface.h"
 
 #define LOCTEXT_NAMESPACE "FSimpleInteractionSystemModule"
 
 void FSimpleInteractionSystemModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FSimpleInterfaceDispatch::Startup();
 }
 
 void FSimpleInteractionSystemModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FSimpleInterfaceDispatch::Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
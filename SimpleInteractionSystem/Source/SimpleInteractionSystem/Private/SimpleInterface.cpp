@@ -2,6 +2,190 @@
 
 
 #include "../Public/SimpleInterface.h"
+#include "Engine/HitResult.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
 
 
 // Add default functionality here for any ISimpleInterface functions that are not pure virtual.
+
+namespace SimpleInterfaceDispatch
+{
+	enum class EEvent : uint8
+	{
+		None = 0,
+		OnHit = 1 << 0,
+		OnStopHit = 1 << 1,
+		OnBeginInteraction = 1 << 2,
+		OnEndInteraction = 1 << 3,
+	};
+	ENUM_CLASS_FLAGS(EEvent);
+
+	static TMap<TWeakObjectPtr<const UClass>, EEvent> ScriptOverridesByClass;
+
+	static FDelegateHandle ObjectsReinstancedHandle;
+	static FDelegateHandle PostWorldInitializationHandle;
+
+	/**
+	 * @return True if the class overrides the event with a Blueprint graph.
+	 */
+	static bool IsScriptOverride(const UClass* Class, FName EventName)
+	{
+		const UFunction* Function = Class->FindFunctionByName(EventName);
+		return Function && !Function->GetOwnerClass()->HasAnyClassFlags(CLASS_Native);
+	}
+
+	/**
+	 * @return The events the class overrides in Blueprint. Computed once per class until the cache is reset.
+	 */
+	static EEvent GetScriptOverrides(const UClass* Class)
+	{
+		if(const EEvent* ScriptOverrides = ScriptOverridesByClass.Find(Class))
+		{
+			return *ScriptOverrides;
+		}
+
+		EEvent ScriptOverrides = EEvent::None;
+		if(IsScriptOverride(Class, GET_FUNCTION_NAME_CHECKED(ISimpleInterface, OnHit)))
+		{
+			ScriptOverrides |= EEvent::OnHit;
+		}
+		if(IsScriptOverride(Class, GET_FUNCTION_NAME_CHECKED(ISimpleInterface, OnStopHit)))
+		{
+			ScriptOverrides |= EEvent::OnStopHit;
+		}
+		if(IsScriptOverride(Class, GET_FUNCTION_NAME_CHECKED(ISimpleInterface, OnBeginInteraction)))
+		{
+			ScriptOverrides |= EEvent::OnBeginInteraction;
+		}
+		if(IsScriptOverride(Class, GET_FUNCTION_NAME_CHECKED(ISimpleInterface, OnEndInteraction)))
+		{
+			ScriptOverrides |= EEvent::OnEndInteraction;
+		}
+		ScriptOverridesByClass.Add(Class, ScriptOverrides);
+		return ScriptOverrides;
+	}
+
+	/**
+	 * @return The native interface of the object if the event can skip ProcessEvent, otherwise nullptr.
+	 */
+	static ISimpleInterface* GetNativeImplementer(UObject* Object, EEvent Event)
+	{
+		ISimpleInterface* Interface = Cast<ISimpleInterface>(Object);
+		if(!Interface || EnumHasAnyFlags(GetScriptOverrides(Object->GetClass()), Event))
+		{
+			return nullptr;
+		}
+		return Interface;
+	}
+}
+
+/**
+ * @brief Registers the cache resets. Called when the module starts up.
+ *
+ * Blueprint compiles that change a class's functions reinstance it, so the cache is cleared on reinstancing as
+ * well as for every new world, which also covers PIE sessions.
+ */
+void FSimpleInterfaceDispatch::Startup()
+{
+	using namespace SimpleInterfaceDispatch;
+
+	ObjectsReinstancedHandle = FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda([](const FCoreUObjectDelegates::FReplacementObjectMap&)
+	{
+		ResetCache();
+	});
+	PostWorldInitializationHandle = FWorldDelegates::OnPostWorldInitialization.AddLambda([](UWorld*, const UWorld::InitializationValues)
+	{
+		ResetCache();
+	});
+}
+
+/**
+ * @brief Unregisters the cache resets and clears the cache. Called when the module shuts down.
+ */
+void FSimpleInterfaceDispatch::Shutdown()
+{
+	using namespace SimpleInterfaceDispatch;
+
+	FCoreUObjectDelegates::OnObjectsReinstanced.Remove(ObjectsReinstancedHandle);
+	FWorldDelegates::OnPostWorldInitialization.Remove(PostWorldInitializationHandle);
+
+	ResetCache();
+}
+
+/**
+ * @brief Forgets all cached Blueprint override results.
+ */
+void FSimpleInterfaceDispatch::ResetCache()
+{
+	SimpleInterfaceDispatch::ScriptOverridesByClass.Reset();
+}
+
+/**
+ * @brief Calls OnHit on the object, bypassing ProcessEvent for native implementers.
+ *
+ * @param Object The object implementing ISimpleInterface.
+ * @param OutHit The hit result passed to the event.
+ */
+void FSimpleInterfaceDispatch::OnHit(UObject* Object, FHitResult& OutHit)
+{
+	if(ISimpleInterface* Interface = SimpleInterfaceDispatch::GetNativeImplementer(Object, SimpleInterfaceDispatch::EEvent::OnHit))
+	{
+		Interface->OnHit_Implementation(OutHit);
+	}
+	else
+	{
+		ISimpleInterface::Execute_OnHit(Object, OutHit);
+	}
+}
+
+/**
+ * @brief Calls OnStopHit on the object, bypassing ProcessEvent for native implementers.
+ *
+ * @param Object The object implementing ISimpleInterface.
+ */
+void FSimpleInterfaceDispatch::OnStopHit(UObject* Object)
+{
+	if(ISimpleInterface* Interface = SimpleInterfaceDispatch::GetNativeImplementer(Object, SimpleInterfaceDispatch::EEvent::OnStopHit))
+	{
+		Interface->OnStopHit_Implementation();
+	}
+	else
+	{
+		ISimpleInterface::Execute_OnStopHit(Object);
+	}
+}
+
+/**
+ * @brief Calls OnBeginInteraction on the object, bypassing ProcessEvent for native implementers.
+ *
+ * @param Object The object implementing ISimpleInterface.
+ */
+void FSimpleInterfaceDispatch::OnBeginInteraction(UObject* Object)
+{
+	if(ISimpleInterface* Interface = SimpleInterfaceDispatch::GetNativeImplementer(Object, SimpleInterfaceDispatch::EEvent::OnBeginInteraction))
+	{
+		Interface->OnBeginInteraction_Implementation();
+	}
+	else
+	{
+		ISimpleInterface::Execute_OnBeginInteraction(Object);
+	}
+}
+
+/**
+ * @brief Calls OnEndInteraction on the object, bypassing ProcessEvent for native implementers.
+ *
+ * @param Object The object implementing ISimpleInterface.
+ */
+void FSimpleInterfaceDispatch::OnEndInteraction(UObject* Object)
+{
+	if(ISimpleInterface* Interface = SimpleInterfaceDispatch::GetNativeImplementer(Object, SimpleInterfaceDispatch::EEvent::OnEndInteraction))
+	{
+		Interface->OnEndInteraction_Implementation();
+	}
+	else
+	{
+		ISimpleInterface::Execute_OnEndInteraction(Object);
+	}
+}
@@ -3,13 +3,50 @@
 
 #include "../Public/SimpleTraceComponent.h"
 #include "../Public/SimpleTraceableComponent.h"
+#include "../Public/SimpleTraceSubsystem.h"
 #include "Camera/CameraComponent.h"
 #include "Components/InputComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/PhysicsSettings.h"
 
 DEFINE_LOG_CATEGORY(LogSimpleInteractionSystem);
 
+/**
+ * @brief Compares the settings that affect the trace query without allocating.
+ *
+ * Shared by the trace subsystem and the recorder to detect settings changed at runtime.
+ *
+ * @param Other The settings to compare with.
+ */
+bool FSimpleLineTrace::HasSameQuery(const FSimpleLineTrace& Other) const
+{
+	return TraceDistance == Other.TraceDistance
+		&& bTraceComplex == Other.bTraceComplex
+		&& bIgnoreSelf == Other.bIgnoreSelf
+		&& ObjectTypes == Other.ObjectTypes
+		&& ActorsToIgnore == Other.ActorsToIgnore;
+}
+
+/**
+ * @brief Builds query params matching the ones the component's own trace uses.
+ *
+ * Shared by the coalesced traces and the replay commandlet so their hits and cost match what players get.
+ *
+ * @param bInTraceComplex True to trace against complex collision.
+ */
+FCollisionQueryParams FSimpleLineTrace::MakeQueryParams(bool bInTraceComplex)
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SimpleLineTrace), bInTraceComplex);
+	QueryParams.bReturnPhysicalMaterial = true;
+	QueryParams.bReturnFaceIndex = !UPhysicsSettings::Get()->bSuppressFaceRemapTable;
+	return QueryParams;
+}
+
 /**
  * Constructor for USimpleTraceComponent class.
  *
@@ -29,6 +66,30 @@ void USimpleTraceComponent::BeginPlay()
 	
 	PerformChecks();
 	SetKeyBinds();
+
+	TraceSubsystem = GetWorld()->GetSubsystem<USimpleTraceSubsystem>();
+	if(TraceSubsystem)
+	{
+		TraceSubsystem->RegisterTraceComponent(this);
+	}
+
+	if(bRecordSession || FParse::Param(FCommandLine::Get(), TEXT("SimpleTraceRecord")))
+	{
+		StartRecording();
+	}
+}
+
+// Called when the game ends
+void USimpleTraceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(TraceSubsystem)
+	{
+		TraceSubsystem->UnregisterTraceComponent(this);
+		TraceSubsystem = nullptr;
+	}
+	Recorder.Reset();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -37,6 +98,11 @@ void USimpleTraceComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 	
 	TraceForObjects();
+
+	if(Recorder)
+	{
+		RecordFrame(DeltaTime);
+	}
 }
 
 /**
@@ -63,6 +129,38 @@ void USimpleTraceComponent::PerformChecks()
 	}
 }
 
+/**
+ * @brief Starts streaming this component's session into the profiling directory.
+ *
+ * The recording can be replayed headlessly with the SimpleTraceReplay commandlet.
+ */
+void USimpleTraceComponent::StartRecording()
+{
+	const FString FileName = FString::Printf(TEXT("%s_%s_%s.sitrace"), *GetNameSafe(GetOwner()), *GetName(), *FDateTime::Now().ToString());
+	const FString FilePath = FPaths::ProfilingDir() / TEXT("SimpleInteraction") / FileName;
+	const FString MapName = GetWorld() ? GetWorld()->GetOutermost()->GetName() : FString();
+
+	Recorder = MakeUnique<FSimpleTraceRecorder>(FilePath, UWorld::RemovePIEPrefix(MapName));
+	if(!Recorder->IsValid())
+	{
+		Recorder.Reset();
+		return;
+	}
+
+	UE_LOG(LogSimpleInteractionSystem, Log, TEXT("'%s' Recording trace session to '%s'."), *GetNameSafe(this), *FilePath);
+}
+
+/**
+ * @brief Records the trace of this frame.
+ *
+ * @param DeltaTime The frame delta time.
+ */
+void USimpleTraceComponent::RecordFrame(float DeltaTime)
+{
+	const FRotator TraceRotation = CameraComponent ? CameraComponent->GetComponentRotation() : GetOwner()->GetActorRotation();
+	Recorder->RecordFrame(DeltaTime, GetStartTraceLocation(), TraceRotation, LineTraceDetails, HitResult);
+}
+
 /**
  * @brief Binds the specified key to the functions for button press and release.
  *
@@ -91,13 +189,23 @@ void USimpleTraceComponent::SetKeyBinds()
 
 /**
  * @brief Performs a line trace for objects in the world.
+ *
+ * Components sharing a camera and trace settings with other components reuse one coalesced query from
+ * USimpleTraceSubsystem. Everything else traces on its own.
  */
 void USimpleTraceComponent::TraceForObjects()
 {
-	bool bHit = UKismetSystemLibrary::LineTraceSingleForObjects(GetOwner(), CameraComponent ? CameraComponent->GetComponentLocation() : GetOwner()->GetActorLocation(), GetEndTraceLocation(),
-																LineTraceDetails.ObjectTypes, LineTraceDetails.bTraceComplex, LineTraceDetails.ActorsToIgnore,
-																LineTraceDetails.DebugType, HitResult, LineTraceDetails.bIgnoreSelf,
-																LineTraceDetails.TraceColor, LineTraceDetails.TraceHitColor, LineTraceDetails.DrawTime);
+	const FVector Start = GetStartTraceLocation();
+	const FVector End = GetEndTraceLocation();
+
+	bool bHit = false;
+	if(!TraceSubsystem || !TraceSubsystem->TraceCoalesced(this, Start, End, HitResult, bHit))
+	{
+		bHit = UKismetSystemLibrary::LineTraceSingleForObjects(GetOwner(), Start, End,
+															   LineTraceDetails.ObjectTypes, LineTraceDetails.bTraceComplex, LineTraceDetails.ActorsToIgnore,
+															   LineTraceDetails.DebugType, HitResult, LineTraceDetails.bIgnoreSelf,
+															   LineTraceDetails.TraceColor, LineTraceDetails.TraceHitColor, LineTraceDetails.DrawTime);
+	}
 
 	
 	if(bHit)
@@ -182,7 +290,7 @@ void USimpleTraceComponent::OnCantTrace()
  * This function checks if there is a current component from hit. If there is, it compares it with the simple traceable component obtained from GetSimpleTraceableComponent().
  * If they are not equal, it calls BroadcastAndExecuteOnExit() function. Otherwise, it calls BroadcastAndExecuteOnHit() function.
  *
- * If there is no current component from hit, it assigns the value of GetSimpleTraceableComponent() to CurrentComponentFromHit and calls BroadcastAndExecuteOnHit() function.
+ * If there is no current component from hit, it assigns the value of GetSimpleTraceableComponent() to CurrentComponentFromHit, broadcasts OnFocusChangedDel and calls BroadcastAndExecuteOnHit() function.
  */
 void USimpleTraceComponent::OnCanTrace()
 {
@@ -201,6 +309,7 @@ void USimpleTraceComponent::OnCanTrace()
 	else
 	{
 		CurrentComponentFromHit = GetSimpleTraceableComponent();
+		OnFocusChangedDel.Broadcast(nullptr, CurrentComponentFromHit);
 		BroadcastAndExecuteOnHit();
 	}
 }
@@ -210,18 +319,18 @@ void USimpleTraceComponent::OnCanTrace()
  *
  * This method is called when the trace component hits a traceable component.
  * It broadcasts the hit event by calling the OnHitDel delegate and passes the
- * HitResult as a parameter. It then calls the Execute_OnHit function, passing
+ * HitResult as a parameter. It then dispatches OnHit through FSimpleInterfaceDispatch, passing
  * CurrentComponentFromHit and HitResult as parameters.
  *
  * @see OnHitDel
- * @see Execute_OnHit
+ * @see FSimpleInterfaceDispatch::OnHit
  * @see HitResult
  * @see CurrentComponentFromHit
  */
 void USimpleTraceComponent::BroadcastAndExecuteOnHit()
 {
 	OnHitDel.Broadcast(HitResult);
-	Execute_OnHit(CurrentComponentFromHit, HitResult);
+	FSimpleInterfaceDispatch::OnHit(CurrentComponentFromHit, HitResult);
 }
 
 /**
@@ -230,13 +339,15 @@ void USimpleTraceComponent::BroadcastAndExecuteOnHit()
  * This method is called to broadcast the OnExitDel delegate, which can be bound to other functions or event listeners.
  * It also executes the OnExit function, passing the CurrentComponentFromHit as a parameter.
  *
- * @note This method sets the CurrentComponentFromHit to nullptr after execution.
+ * @note This method sets the CurrentComponentFromHit to nullptr after execution and broadcasts OnFocusChangedDel.
  */
 void USimpleTraceComponent::BroadcastAndExecuteOnExit()
 {
 	OnStopHitDel.Broadcast();
-	Execute_OnStopHit(CurrentComponentFromHit);
+	FSimpleInterfaceDispatch::OnStopHit(CurrentComponentFromHit);
+	USimpleTraceableComponent* PreviousFocus = CurrentComponentFromHit;
 	CurrentComponentFromHit = nullptr;
+	OnFocusChangedDel.Broadcast(PreviousFocus, nullptr);
 }
 
 /**
@@ -244,17 +355,22 @@ void USimpleTraceComponent::BroadcastAndExecuteOnExit()
  *
  * This method is called when the button is pressed.
  * It checks whether the current component from the hit result is valid and broadcasts the OnBeginInteractionDel delegate.
- * It also calls the Execute_OnBeginInteraction method for the current component from the hit result.
+ * It also dispatches OnBeginInteraction to the current component from the hit result.
  * It sets the bCanTrace flag to false.
  *
  * @return void
  */
 void USimpleTraceComponent::OnButtonPressed()
 {
+	if(Recorder)
+	{
+		Recorder->RecordInteractionKey(true);
+	}
+
 	if(CurrentComponentFromHit)
 	{
 		OnBeginInteractionDel.Broadcast();
-		Execute_OnBeginInteraction(CurrentComponentFromHit);
+		FSimpleInterfaceDispatch::OnBeginInteraction(CurrentComponentFromHit);
 		bCanTrace = false;
 	}
 }
@@ -263,24 +379,37 @@ void USimpleTraceComponent::OnButtonPressed()
  * @brief This function is called when the button is released.
  *
  * If there is a current component from the hit, the function checks if tracing is allowed.
- * If tracing is not allowed, the OnEndInteractionDel and Execute_OnEndInteraction are broadcasted and executed, respectively.
+ * If tracing is not allowed, the OnEndInteractionDel is broadcasted and OnEndInteraction is dispatched to the current component.
  * The bCanTrace flag is set to true.
  *
- * @see OnEndInteractionDel, Execute_OnEndInteraction
+ * @see OnEndInteractionDel, FSimpleInterfaceDispatch::OnEndInteraction
  */
 void USimpleTraceComponent::OnButtonReleased()
 {
+	if(Recorder)
+	{
+		Recorder->RecordInteractionKey(false);
+	}
+
 	if(CurrentComponentFromHit)
 	{
 		if(!bCanTrace)
 		{
 			OnEndInteractionDel.Broadcast();
-			Execute_OnEndInteraction(CurrentComponentFromHit);
+			FSimpleInterfaceDispatch::OnEndInteraction(CurrentComponentFromHit);
 			bCanTrace = true;
 		}
 	}
 }
 
+/**
+ * @return The start location of the trace
+ */
+FVector USimpleTraceComponent::GetStartTraceLocation() const
+{
+	return CameraComponent ? CameraComponent->GetComponentLocation() : GetOwner()->GetActorLocation();
+}
+
 /**
  * @return The end location of the trace
  */
@@ -289,6 +418,14 @@ FVector USimpleTraceComponent::GetEndTraceLocation() const
 	return CameraComponent ? CameraComponent->GetComponentLocation() + CameraComponent->GetForwardVector() * LineTraceDetails.TraceDistance : GetOwner()->GetActorLocation();
 }
 
+/**
+ * @return The SimpleTraceableComponent currently in focus, or nullptr if nothing is focused.
+ */
+USimpleTraceableComponent* USimpleTraceComponent::GetFocusedComponent() const
+{
+	return CurrentComponentFromHit;
+}
+
 /**
  * @return The SimpleTraceableComponent associated with the hit actor.
  */
@@ -0,0 +1,237 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+
+#include "../Public/SimpleTraceRecorder.h"
+#include "../Public/SimpleTraceComponent.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+/**
+ * @brief Captures the query-relevant parts of the line trace settings.
+ *
+ * @param LineTrace The settings of the trace component.
+ */
+FSimpleTraceSettingsRecord::FSimpleTraceSettingsRecord(const FSimpleLineTrace& LineTrace)
+	: TraceDistance(LineTrace.TraceDistance)
+	, bTraceComplex(LineTrace.bTraceComplex)
+{
+	ObjectTypes.Reserve(LineTrace.ObjectTypes.Num());
+	for(const TEnumAsByte<EObjectTypeQuery> ObjectType : LineTrace.ObjectTypes)
+	{
+		ObjectTypes.Add(ObjectType.GetValue());
+	}
+
+	ActorsToIgnore.Reserve(LineTrace.ActorsToIgnore.Num());
+	for(const AActor* Actor : LineTrace.ActorsToIgnore)
+	{
+		ActorsToIgnore.Add(GetNameSafe(Actor));
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FSimpleTraceSettingsRecord& Settings)
+{
+	Ar << Settings.TraceDistance;
+	Ar << Settings.ObjectTypes;
+	Ar << Settings.bTraceComplex;
+	Ar << Settings.ActorsToIgnore;
+	return Ar;
+}
+
+/**
+ * @brief Opens the output file and writes the stream header.
+ *
+ * @param FilePath The file to record into. Missing directories are created.
+ * @param MapName The map the session is played on.
+ */
+FSimpleTraceRecorder::FSimpleTraceRecorder(const FString& FilePath, const FString& MapName)
+{
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+	if(!Writer)
+	{
+		UE_LOG(LogSimpleInteractionSystem, Error, TEXT("Could not open '%s' for recording."), *FilePath);
+		return;
+	}
+
+	uint32 HeaderMagic = Magic;
+	uint32 HeaderVersion = Version;
+	FString HeaderMapName = MapName;
+	*Writer << HeaderMagic << HeaderVersion << HeaderMapName;
+}
+
+FSimpleTraceRecorder::~FSimpleTraceRecorder()
+{
+	if(Writer)
+	{
+		Writer->Close();
+	}
+}
+
+/**
+ * @return True if the output file is open.
+ */
+bool FSimpleTraceRecorder::IsValid() const
+{
+	return Writer.IsValid();
+}
+
+/**
+ * @brief Marks an interaction key event to be stored with the next frame.
+ *
+ * @param bPressed True for a press, false for a release.
+ */
+void FSimpleTraceRecorder::RecordInteractionKey(bool bPressed)
+{
+	PendingFlags |= bPressed ? ESimpleTraceFrameFlags::InteractionPressed : ESimpleTraceFrameFlags::InteractionReleased;
+}
+
+/**
+ * @brief Appends one frame to the stream.
+ *
+ * Settings are only written when they differ from the last written ones and hit data only when something was hit.
+ *
+ * @param DeltaTime The frame delta time.
+ * @param CameraLocation The trace start location.
+ * @param CameraRotation The trace direction.
+ * @param LineTrace The line trace settings used this frame.
+ * @param HitResult The result of this frame's trace.
+ */
+void FSimpleTraceRecorder::RecordFrame(float DeltaTime, const FVector& CameraLocation, const FRotator& CameraRotation, const FSimpleLineTrace& LineTrace, const FHitResult& HitResult)
+{
+	if(!Writer)
+	{
+		return;
+	}
+
+	ESimpleTraceFrameFlags Flags = PendingFlags;
+	PendingFlags = ESimpleTraceFrameFlags::None;
+	if(!LastLineTrace || !LastLineTrace->HasSameQuery(LineTrace))
+	{
+		Flags |= ESimpleTraceFrameFlags::SettingsChanged;
+	}
+	if(HitResult.bBlockingHit)
+	{
+		Flags |= ESimpleTraceFrameFlags::Hit;
+	}
+
+	uint8 FlagsByte = static_cast<uint8>(Flags);
+	*Writer << FlagsByte;
+
+	if(EnumHasAnyFlags(Flags, ESimpleTraceFrameFlags::SettingsChanged))
+	{
+		if(LastLineTrace)
+		{
+			*LastLineTrace = LineTrace;
+		}
+		else
+		{
+			LastLineTrace = MakeUnique<FSimpleLineTrace>(LineTrace);
+		}
+
+		FSimpleTraceSettingsRecord Settings(LineTrace);
+		*Writer << Settings;
+	}
+
+	FVector3f Location(CameraLocation);
+	FRotator3f Rotation(CameraRotation);
+	*Writer << DeltaTime << Location << Rotation;
+
+	if(EnumHasAnyFlags(Flags, ESimpleTraceFrameFlags::Hit))
+	{
+		FVector3f ImpactPoint(HitResult.ImpactPoint);
+		*Writer << ImpactPoint;
+
+		const FName HitActor = HitResult.GetActor() ? HitResult.GetActor()->GetFName() : NAME_None;
+		int32 NameIndex = NameTable.Num();
+		if(const int32* ExistingIndex = NameTable.Find(HitActor))
+		{
+			NameIndex = *ExistingIndex;
+			*Writer << NameIndex;
+		}
+		else
+		{
+			NameTable.Add(HitActor, NameIndex);
+			FString HitActorName = HitActor.ToString();
+			*Writer << NameIndex << HitActorName;
+		}
+	}
+}
+
+/**
+ * @brief Opens a recording and validates its header.
+ *
+ * @param InFilePath The recording to read.
+ * @return True if the file exists and was written by a compatible recorder.
+ */
+bool FSimpleTraceRecordingReader::Open(const FString& InFilePath)
+{
+	Reader.Reset(IFileManager::Get().CreateFileReader(*InFilePath));
+	if(!Reader)
+	{
+		UE_LOG(LogSimpleInteractionSystem, Error, TEXT("Could not open recording '%s'."), *InFilePath);
+		return false;
+	}
+
+	uint32 HeaderMagic = 0;
+	uint32 HeaderVersion = 0;
+	*Reader << HeaderMagic << HeaderVersion;
+	if(Reader->IsError() || HeaderMagic != FSimpleTraceRecorder::Magic || HeaderVersion != FSimpleTraceRecorder::Version)
+	{
+		UE_LOG(LogSimpleInteractionSystem, Error, TEXT("'%s' is not a supported trace recording."), *InFilePath);
+		Reader.Reset();
+		return false;
+	}
+
+	*Reader << MapName;
+	NameTable.Reset();
+	return !Reader->IsError();
+}
+
+/**
+ * @return The map the recording was captured on.
+ */
+const FString& FSimpleTraceRecordingReader::GetMapName() const
+{
+	return MapName;
+}
+
+bool FSimpleTraceRecordingReader::ReadFrame(FSimpleTraceFrameRecord& OutFrame, FSimpleTraceSettingsRecord& InOutSettings)
+{
+	if(!Reader || Reader->AtEnd())
+	{
+		return false;
+	}
+
+	uint8 FlagsByte = 0;
+	*Reader << FlagsByte;
+	OutFrame.Flags = static_cast<ESimpleTraceFrameFlags>(FlagsByte);
+
+	if(EnumHasAnyFlags(OutFrame.Flags, ESimpleTraceFrameFlags::SettingsChanged))
+	{
+		*Reader << InOutSettings;
+	}
+
+	*Reader << OutFrame.DeltaTime << OutFrame.CameraLocation << OutFrame.CameraRotation;
+
+	OutFrame.ImpactPoint = FVector3f::ZeroVector;
+	OutFrame.HitActor = NAME_None;
+	if(EnumHasAnyFlags(OutFrame.Flags, ESimpleTraceFrameFlags::Hit))
+	{
+		int32 NameIndex = INDEX_NONE;
+		*Reader << OutFrame.ImpactPoint << NameIndex;
+		if(NameIndex == NameTable.Num())
+		{
+			FString HitActorName;
+			*Reader << HitActorName;
+			NameTable.Add(FName(*HitActorName));
+		}
+		if(!NameTable.IsValidIndex(NameIndex))
+		{
+			UE_LOG(LogSimpleInteractionSystem, Error, TEXT("Corrupt trace recording: invalid name index %d."), NameIndex);
+			return false;
+		}
+		OutFrame.HitActor = NameTable[NameIndex];
+	}
+
+	return !Reader->IsError();
+}
@@ -0,0 +1,319 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+
+#include "../Public/SimpleTraceReplayCommandlet.h"
+#include "../Public/SimpleComponent.h"
+#include "../Public/SimpleTraceComponent.h"
+#include "../Public/SimpleTraceableComponent.h"
+#include "../Public/SimpleTraceRecorder.h"
+#include "Engine/Level.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/Package.h"
+
+namespace
+{
+	/**
+	 * Mirrors how USimpleTraceComponent moves its focus: only interactable actors gain focus, switching targets
+	 * passes through one frame without focus and focus is locked between an interaction press and release.
+	 */
+	struct FReplayFocus
+	{
+		FName Focus = NAME_None;
+		bool bInteracting = false;
+		int32 Changes = 0;
+
+		void Update(bool bPressed, bool bReleased, FName InteractableHit)
+		{
+			if(bPressed && Focus != NAME_None)
+			{
+				bInteracting = true;
+			}
+			if(bReleased && Focus != NAME_None)
+			{
+				bInteracting = false;
+			}
+			if(bInteracting)
+			{
+				return;
+			}
+
+			if(InteractableHit != NAME_None && Focus == NAME_None)
+			{
+				Focus = InteractableHit;
+				++Changes;
+			}
+			else if(Focus != NAME_None && InteractableHit != Focus)
+			{
+				Focus = NAME_None;
+				++Changes;
+			}
+		}
+	};
+}
+
+USimpleTraceReplayCommandlet::USimpleTraceReplayCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+/**
+ * @brief Replays every recorded frame with the recorded or overridden trace settings.
+ *
+ * @param Params The commandlet parameters.
+ * @return 0 on success, 1 if the recording or map could not be loaded.
+ */
+int32 USimpleTraceReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingPath;
+	if(!FParse::Value(*Params, TEXT("Recording="), RecordingPath))
+	{
+		UE_LOG(LogSimpleInteractionSystem, Error, TEXT("Missing -Recording=<file.sitrace>."));
+		return 1;
+	}
+
+	FSimpleTraceRecordingReader Reader;
+	if(!Reader.Open(RecordingPath))
+	{
+		return 1;
+	}
+
+	FString MapName = Reader.GetMapName();
+	FParse::Value(*Params, TEXT("Map="), MapName);
+
+	FString TraceMode = TEXT("Single");
+	FParse::Value(*Params, TEXT("TraceMode="), TraceMode);
+	const bool bMultiTrace = TraceMode.Equals(TEXT("Multi"), ESearchCase::IgnoreCase);
+
+	double TraceDistanceOverride = 0.0;
+	const bool bOverrideTraceDistance = FParse::Value(*Params, TEXT("TraceDistance="), TraceDistanceOverride);
+	bool bTraceComplexOverride = true;
+	const bool bOverrideTraceComplex = FParse::Bool(*Params, TEXT("TraceComplex="), bTraceComplexOverride);
+
+	UWorld* World = LoadWorld(MapName);
+	if(!World)
+	{
+		return 1;
+	}
+
+	TMap<FName, AActor*> ActorsByName;
+	TSet<FName> InteractableActors;
+	for(TActorIterator<AActor> It(World); It; ++It)
+	{
+		ActorsByName.Add(It->GetFName(), *It);
+		if(It->FindComponentByClass<USimpleTraceableComponent>())
+		{
+			InteractableActors.Add(It->GetFName());
+		}
+	}
+
+	int32 Frames = 0;
+	int32 SettingsChanges = 0;
+	int32 RecordedHits = 0;
+	int32 ReplayedHits = 0;
+	int32 HitMismatches = 0;
+	int32 MatchedHits = 0;
+	int32 InteractionPresses = 0;
+	int32 InteractionReleases = 0;
+	double SessionSeconds = 0.0;
+	double TotalImpactDrift = 0.0;
+	double MaxImpactDrift = 0.0;
+	uint64 TotalTraceCycles = 0;
+	uint64 MaxTraceCycles = 0;
+
+	FSimpleTraceSettingsRecord Settings;
+	FSimpleTraceFrameRecord Frame;
+	FCollisionObjectQueryParams ObjectQueryParams;
+	FCollisionQueryParams QueryParams;
+	FReplayFocus RecordedFocus;
+	FReplayFocus ReplayedFocus;
+	TArray<FHitResult> MultiHits;
+
+	while(Reader.ReadFrame(Frame, Settings))
+	{
+		++Frames;
+		SessionSeconds += Frame.DeltaTime;
+
+		if(EnumHasAnyFlags(Frame.Flags, ESimpleTraceFrameFlags::SettingsChanged))
+		{
+			++SettingsChanges;
+
+			TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
+			for(const uint8 ObjectType : Settings.ObjectTypes)
+			{
+				ObjectTypes.Add(static_cast<EObjectTypeQuery>(ObjectType));
+			}
+			ObjectQueryParams = FCollisionObjectQueryParams(ObjectTypes);
+
+			QueryParams = FSimpleLineTrace::MakeQueryParams(bOverrideTraceComplex ? bTraceComplexOverride : Settings.bTraceComplex);
+			for(const FString& ActorName : Settings.ActorsToIgnore)
+			{
+				if(AActor** Actor = ActorsByName.Find(FName(*ActorName)))
+				{
+					QueryParams.AddIgnoredActor(*Actor);
+				}
+			}
+		}
+
+		const bool bPressed = EnumHasAnyFlags(Frame.Flags, ESimpleTraceFrameFlags::InteractionPressed);
+		const bool bReleased = EnumHasAnyFlags(Frame.Flags, ESimpleTraceFrameFlags::InteractionReleased);
+		InteractionPresses += bPressed ? 1 : 0;
+		InteractionReleases += bReleased ? 1 : 0;
+
+		const bool bRecordedHit = EnumHasAnyFlags(Frame.Flags, ESimpleTraceFrameFlags::Hit);
+		RecordedHits += bRecordedHit ? 1 : 0;
+		RecordedFocus.Update(bPressed, bReleased, InteractableActors.Contains(Frame.HitActor) ? Frame.HitActor : NAME_None);
+
+		FName ReplayedHitActor = NAME_None;
+		if(ObjectQueryParams.IsValid())
+		{
+			const FVector Start(Frame.CameraLocation);
+			const FVector End = Start + FVector(Frame.CameraRotation.Vector()) * (bOverrideTraceDistance ? TraceDistanceOverride : Settings.TraceDistance);
+
+			FHitResult Hit;
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			bool bHit;
+			if(bMultiTrace)
+			{
+				// Object queries report their hits as touches, so the return value is not a reliable hit flag.
+				World->LineTraceMultiByObjectType(MultiHits, Start, End, ObjectQueryParams, QueryParams);
+				bHit = MultiHits.Num() > 0;
+				if(bHit)
+				{
+					Hit = MultiHits[0];
+				}
+			}
+			else
+			{
+				bHit = World->LineTraceSingleByObjectType(Hit, Start, End, ObjectQueryParams, QueryParams);
+			}
+			const uint64 TraceCycles = FPlatformTime::Cycles64() - StartCycles;
+			TotalTraceCycles += TraceCycles;
+			MaxTraceCycles = FMath::Max(MaxTraceCycles, TraceCycles);
+
+			ReplayedHits += bHit ? 1 : 0;
+			ReplayedHitActor = bHit && Hit.GetActor() ? Hit.GetActor()->GetFName() : NAME_None;
+			if(bHit != bRecordedHit || ReplayedHitActor != Frame.HitActor)
+			{
+				++HitMismatches;
+			}
+			else if(bHit)
+			{
+				const double ImpactDrift = FVector::Dist(FVector(Frame.ImpactPoint), Hit.ImpactPoint);
+				TotalImpactDrift += ImpactDrift;
+				MaxImpactDrift = FMath::Max(MaxImpactDrift, ImpactDrift);
+				++MatchedHits;
+			}
+		}
+		ReplayedFocus.Update(bPressed, bReleased, InteractableActors.Contains(ReplayedHitActor) ? ReplayedHitActor : NAME_None);
+	}
+
+	UnloadWorld(World);
+
+	const double TotalTraceMs = FPlatformTime::ToMilliseconds64(TotalTraceCycles);
+	UE_LOG(LogSimpleInteractionSystem, Display, TEXT("Replayed '%s' on '%s' (%s trace)."), *RecordingPath, *MapName, bMultiTrace ? TEXT("Multi") : TEXT("Single"));
+	UE_LOG(LogSimpleInteractionSystem, Display, TEXT("  Frames: %d over %.1f s of gameplay, settings changes: %d"), Frames, SessionSeconds, SettingsChanges);
+	UE_LOG(LogSimpleInteractionSystem, Display, TEXT("  Hits recorded: %d, replayed: %d, mismatched frames: %d"), RecordedHits, ReplayedHits, HitMismatches);
+	UE_LOG(LogSimpleInteractionSystem, Display, TEXT("  Impact point drift on matching hits: avg %.2f cm, max %.2f cm"), MatchedHits > 0 ? TotalImpactDrift / MatchedHits : 0.0, MaxImpactDrift);
+	UE_LOG(LogSimpleInteractionSystem, Display, TEXT("  Focus changes recorded: %d, replayed: %d"), RecordedFocus.Changes, ReplayedFocus.Changes);
+	UE_LOG(LogSimpleInteractionSystem, Display, TEXT("  Interaction presses: %d, releases: %d"), InteractionPresses, InteractionReleases);
+	UE_LOG(LogSimpleInteractionSystem, Display, TEXT("  Trace time total: %.3f ms, avg: %.4f ms, max: %.4f ms, per gameplay second: %.4f ms"),
+		TotalTraceMs, Frames > 0 ? TotalTraceMs / Frames : 0.0, FPlatformTime::ToMilliseconds64(MaxTraceCycles), SessionSeconds > 0.0 ? TotalTraceMs / SessionSeconds : 0.0);
+
+	return 0;
+}
+
+/**
+ * @brief Loads a map package with its streaming levels and initializes only what collision queries need.
+ *
+ * @param MapName The long package name of the map.
+ * @return The initialized world, or nullptr if the map could not be loaded.
+ */
+UWorld* USimpleTraceReplayCommandlet::LoadWorld(const FString& MapName)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if(!World)
+	{
+		UE_LOG(LogSimpleInteractionSystem, Error, TEXT("Could not load map '%s'."), *MapName);
+		return nullptr;
+	}
+
+	World->AddToRoot();
+	if(!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.InitializeScenes(false)
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.SetTransactional(false)
+			.CreateFXSystem(false));
+	}
+	World->UpdateWorldComponents(true, false);
+
+	if(World->IsPartitionedWorld())
+	{
+		UE_LOG(LogSimpleInteractionSystem, Error, TEXT("'%s' is a World Partition map. Replay only supports maps with a persistent level and level streaming."), *MapName);
+		UnloadWorld(World);
+		return nullptr;
+	}
+
+	if(!LoadStreamingLevels(World))
+	{
+		UnloadWorld(World);
+		return nullptr;
+	}
+	return World;
+}
+
+/**
+ * @brief Loads and makes visible every streaming level so traces run against the full scene.
+ *
+ * @param World The world loaded by LoadWorld().
+ * @return False if a streaming level could not be loaded.
+ */
+bool USimpleTraceReplayCommandlet::LoadStreamingLevels(UWorld* World)
+{
+	const TArray<ULevelStreaming*>& StreamingLevels = World->GetStreamingLevels();
+	if(StreamingLevels.Num() == 0)
+	{
+		return true;
+	}
+
+	for(ULevelStreaming* StreamingLevel : StreamingLevels)
+	{
+		StreamingLevel->SetShouldBeLoaded(true);
+		StreamingLevel->SetShouldBeVisible(true);
+	}
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+
+	bool bAllLoaded = true;
+	for(const ULevelStreaming* StreamingLevel : StreamingLevels)
+	{
+		if(!StreamingLevel->GetLoadedLevel() || !StreamingLevel->GetLoadedLevel()->bIsVisible)
+		{
+			UE_LOG(LogSimpleInteractionSystem, Error, TEXT("Could not load streaming level '%s'."), *StreamingLevel->GetWorldAssetPackageName());
+			bAllLoaded = false;
+		}
+	}
+	return bAllLoaded;
+}
+
+/**
+ * @brief Releases a world loaded by LoadWorld().
+ */
+void USimpleTraceReplayCommandlet::UnloadWorld(UWorld* World)
+{
+	World->CleanupWorld();
+	World->RemoveFromRoot();
+}
@@ -0,0 +1,202 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+
+#include "../Public/SimpleTraceSubsystem.h"
+#include "../Public/SimpleTraceComponent.h"
+#include "CollisionQueryParams.h"
+#include "CoreGlobals.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+/**
+ * @brief Adds a trace component to the candidates for coalescing.
+ *
+ * @param TraceComponent The component to register.
+ */
+void USimpleTraceSubsystem::RegisterTraceComponent(USimpleTraceComponent* TraceComponent)
+{
+	TraceComponents.AddUnique(TraceComponent);
+	bGroupsDirty = true;
+}
+
+/**
+ * @brief Removes a trace component from the candidates for coalescing.
+ *
+ * @param TraceComponent The component to unregister.
+ */
+void USimpleTraceSubsystem::UnregisterTraceComponent(USimpleTraceComponent* TraceComponent)
+{
+	TraceComponents.RemoveSingleSwap(TraceComponent);
+	Members.Remove(TraceComponent);
+	bGroupsDirty = true;
+}
+
+/**
+ * @brief Returns the component's hit from its group's shared trace, tracing the group once per frame.
+ *
+ * The group is traced again if the ray moved since the last query of the frame. The query parameters match
+ * UKismetSystemLibrary::LineTraceSingleForObjects so the hit carries the same data as a component's own trace.
+ */
+bool USimpleTraceSubsystem::TraceCoalesced(const USimpleTraceComponent* TraceComponent, const FVector& Start, const FVector& End, FHitResult& OutHit, bool& bOutHit)
+{
+	if(TraceComponents.Num() < 2)
+	{
+		return false;
+	}
+
+	if(CheckedFrame != GFrameCounter)
+	{
+		CheckedFrame = GFrameCounter;
+		if(bGroupsDirty || HaveSettingsChanged())
+		{
+			RebuildGroups();
+		}
+	}
+
+	const FGroupMember* Member = Members.Find(TraceComponent);
+	if(!Member)
+	{
+		return false;
+	}
+
+	FTraceGroup& Group = Groups[Member->GroupIndex];
+	if(Group.TraceFrame != GFrameCounter || Group.TraceStart != Start || Group.TraceEnd != End)
+	{
+		FCollisionQueryParams QueryParams = FSimpleLineTrace::MakeQueryParams(Group.bTraceComplex);
+		QueryParams.AddIgnoredActors(Group.ActorsToIgnore);
+		if(Group.IgnoredOwner)
+		{
+			QueryParams.AddIgnoredActor(Group.IgnoredOwner);
+		}
+
+		// Object queries report every hit along the ray in a multi trace, sorted by distance.
+		GetWorld()->LineTraceMultiByObjectType(Group.Hits, Start, End, FCollisionObjectQueryParams(Group.ObjectTypesToQuery), QueryParams);
+		Group.TraceFrame = GFrameCounter;
+		Group.TraceStart = Start;
+		Group.TraceEnd = End;
+	}
+
+	for(const FHitResult& Hit : Group.Hits)
+	{
+		if(const UPrimitiveComponent* HitComponent = Hit.GetComponent(); HitComponent && (Member->ObjectTypesToQuery & ECC_TO_BITFIELD(HitComponent->GetCollisionObjectType())))
+		{
+			OutHit = Hit;
+			OutHit.bBlockingHit = true;
+			bOutHit = true;
+			return true;
+		}
+	}
+
+	OutHit = FHitResult(Start, End);
+	bOutHit = false;
+	return true;
+}
+
+/**
+ * @return True if any registered component changed its trace settings since the groups were built.
+ */
+bool USimpleTraceSubsystem::HaveSettingsChanged() const
+{
+	for(int32 Index = 0; Index < TraceComponents.Num(); ++Index)
+	{
+		const USimpleTraceComponent* TraceComponent = TraceComponents[Index];
+		const FGroupedSettings& Settings = GroupedSettings[Index];
+		if(!TraceComponent)
+		{
+			if(Settings.Camera)
+			{
+				return true;
+			}
+			continue;
+		}
+		if(Settings.Camera != TraceComponent->CameraComponent
+			|| Settings.LineTrace.DebugType != TraceComponent->LineTraceDetails.DebugType
+			|| !Settings.LineTrace.HasSameQuery(TraceComponent->LineTraceDetails))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Groups the registered components by camera and query settings and merges their object types.
+ *
+ * Components left alone in a group are not coalesced since a single trace is cheaper for them.
+ */
+void USimpleTraceSubsystem::RebuildGroups()
+{
+	bGroupsDirty = false;
+	Groups.Reset();
+	Members.Reset();
+	GroupedSettings.Reset(TraceComponents.Num());
+
+	for(const USimpleTraceComponent* TraceComponent : TraceComponents)
+	{
+		FGroupedSettings& Settings = GroupedSettings.AddDefaulted_GetRef();
+		if(TraceComponent)
+		{
+			Settings.Camera = TraceComponent->CameraComponent;
+			Settings.LineTrace = TraceComponent->LineTraceDetails;
+		}
+		if(!CanCoalesce(TraceComponent))
+		{
+			continue;
+		}
+
+		int32 GroupIndex = Groups.IndexOfByPredicate([TraceComponent](const FTraceGroup& Group) { return BelongsToGroup(Group, TraceComponent); });
+		if(GroupIndex == INDEX_NONE)
+		{
+			const FSimpleLineTrace& LineTrace = TraceComponent->LineTraceDetails;
+			GroupIndex = Groups.AddDefaulted();
+			FTraceGroup& Group = Groups[GroupIndex];
+			Group.Camera = TraceComponent->CameraComponent;
+			Group.TraceDistance = LineTrace.TraceDistance;
+			Group.bTraceComplex = LineTrace.bTraceComplex;
+			Group.IgnoredOwner = LineTrace.bIgnoreSelf ? TraceComponent->GetOwner() : nullptr;
+			Group.ActorsToIgnore = LineTrace.ActorsToIgnore;
+		}
+
+		const int32 ObjectTypesToQuery = FCollisionObjectQueryParams(TraceComponent->LineTraceDetails.ObjectTypes).GetQueryBitfield();
+		FTraceGroup& Group = Groups[GroupIndex];
+		Group.ObjectTypesToQuery |= ObjectTypesToQuery;
+		++Group.NumMembers;
+
+		FGroupMember& Member = Members.Add(TraceComponent);
+		Member.GroupIndex = GroupIndex;
+		Member.ObjectTypesToQuery = ObjectTypesToQuery;
+	}
+
+	for(auto It = Members.CreateIterator(); It; ++It)
+	{
+		if(Groups[It.Value().GroupIndex].NumMembers < 2)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+/**
+ * @return True if the component's trace can be shared. Debug drawing keeps a component on its own trace.
+ */
+bool USimpleTraceSubsystem::CanCoalesce(const USimpleTraceComponent* TraceComponent)
+{
+	return TraceComponent
+		&& TraceComponent->CameraComponent
+		&& TraceComponent->LineTraceDetails.ObjectTypes.Num() > 0
+		&& TraceComponent->LineTraceDetails.DebugType == EDrawDebugTrace::None;
+}
+
+/**
+ * @return True if the component traces the same ray with the same query settings as the group.
+ */
+bool USimpleTraceSubsystem::BelongsToGroup(const FTraceGroup& Group, const USimpleTraceComponent* TraceComponent)
+{
+	const FSimpleLineTrace& LineTrace = TraceComponent->LineTraceDetails;
+	return Group.Camera == TraceComponent->CameraComponent
+		&& Group.TraceDistance == LineTrace.TraceDistance
+		&& Group.bTraceComplex == LineTrace.bTraceComplex
+		&& Group.IgnoredOwner == (LineTrace.bIgnoreSelf ? TraceComponent->GetOwner() : nullptr)
+		&& Group.ActorsToIgnore == LineTrace.ActorsToIgnore;
+}
@@ -0,0 +1,82 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SimpleIndicatorComponent.generated.h"
+
+class AController;
+class APawn;
+class APlayerController;
+class USimpleIndicatorWidget;
+class USimpleTraceComponent;
+class USimpleTraceableComponent;
+
+UCLASS(Blueprintable, ClassGroup=(SimpleInteractionSystem), meta=(BlueprintSpawnableComponent))
+class SIMPLEINTERACTIONSYSTEM_API USimpleIndicatorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	USimpleIndicatorComponent();
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	// Called every frame while an indicator is visible
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Indicator", meta=(ToolTip="Widget spawned above the focused traceable component."))
+	TSubclassOf<USimpleIndicatorWidget> IndicatorWidgetClass;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Indicator", meta=(ClampMin="1", ToolTip="Number of indicator widgets created up front and reused."))
+	int32 PoolSize = 2;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Indicator", meta=(ClampMin="0.0", ToolTip="The indicator is only moved when its projected position changes by more than this many pixels."))
+	float PixelThreshold = 1.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Indicator", meta=(ToolTip="World space offset from the focused actor's location."))
+	FVector IndicatorOffset = FVector(0.0, 0.0, 50.0);
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Indicator", meta=(ToolTip="Viewport Z order of the indicator widgets."))
+	int32 ZOrder = 0;
+
+private:
+	UPROPERTY()
+	TArray<USimpleTraceComponent*> TraceComponents;
+
+	UPROPERTY()
+	TArray<USimpleIndicatorWidget*> FreeIndicators;
+
+	UPROPERTY()
+	TArray<USimpleIndicatorWidget*> ActiveIndicators;
+
+	UPROPERTY()
+	APlayerController* PoolController = nullptr;
+
+	UFUNCTION()
+	void OnFocusChanged(USimpleTraceableComponent* PreviousFocus, USimpleTraceableComponent* NewFocus);
+
+	UFUNCTION()
+	void OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
+	void BindTraceComponents();
+	void FillPool();
+	void ResetPool();
+	void RebuildPool();
+	void ShowIndicator(USimpleTraceableComponent* Target);
+	void HideIndicator(USimpleTraceableComponent* Target);
+	void ReleaseIndicator(int32 Index);
+	bool UpdateIndicator(USimpleIndicatorWidget* Indicator) const;
+	bool IsFocusedByAnyTraceComponent(const USimpleTraceableComponent* Target) const;
+	USimpleIndicatorWidget* AcquireIndicator();
+	USimpleIndicatorWidget* CreateIndicator() const;
+	APlayerController* GetOwningPlayerController() const;
+};
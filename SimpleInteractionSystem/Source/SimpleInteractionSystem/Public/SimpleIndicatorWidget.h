@@ -0,0 +1,50 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "SimpleIndicatorWidget.generated.h"
+
+class USimpleTraceableComponent;
+
+/**
+ * Native base for interaction indicators. Reparent indicator widgets to this class and let
+ * USimpleIndicatorComponent drive them instead of binding to the per-frame OnHitDel.
+ */
+UCLASS(Abstract, Blueprintable, meta=(DisableNativeTick))
+class SIMPLEINTERACTIONSYSTEM_API USimpleIndicatorWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	void ShowForTarget(USimpleTraceableComponent* InTarget);
+	void HideIndicator();
+	void SetOnScreen(bool bInOnScreen);
+	bool UpdateScreenPosition(const FVector2D& NewScreenPosition, float PixelThreshold);
+
+	UFUNCTION(BlueprintPure, Category="Indicator")
+	USimpleTraceableComponent* GetTarget() const;
+
+	UFUNCTION(BlueprintImplementableEvent, Category="Indicator")
+	void OnIndicatorShown(USimpleTraceableComponent* InTarget);
+
+	UFUNCTION(BlueprintImplementableEvent, Category="Indicator")
+	void OnIndicatorHidden();
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Indicator", meta=(ToolTip="Wrap the widget in an invalidation panel so it is only repainted when its content changes."))
+	bool bCacheWidget = true;
+
+protected:
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+
+private:
+	UPROPERTY()
+	USimpleTraceableComponent* Target = nullptr;
+
+	FVector2D LastScreenPosition = FVector2D::ZeroVector;
+
+	bool bHasScreenPosition = false;
+
+	bool bOnScreen = false;
+};
@@ -34,3 +34,22 @@ public:
 	UFUNCTION(BlueprintNativeEvent, Blueprintable, Category="Simple Interface")
 	void OnEndInteraction();
 };
+
+/**
+ * Dispatches ISimpleInterface events without the Blueprint VM when possible.
+ *
+ * Native implementers are called through their _Implementation functions directly. ProcessEvent is only
+ * used when the object's class overrides the event in Blueprint or implements the interface in Blueprint only.
+ * Override detection is cached per class and reset whenever classes are reinstanced and for every new world.
+ */
+struct SIMPLEINTERACTIONSYSTEM_API FSimpleInterfaceDispatch
+{
+	static void Startup();
+	static void Shutdown();
+	static void ResetCache();
+
+	static void OnHit(UObject* Object, FHitResult& OutHit);
+	static void OnStopHit(UObject* Object);
+	static void OnBeginInteraction(UObject* Object);
+	static void OnEndInteraction(UObject* Object);
+};
@@ -8,10 +8,14 @@
 #include "Engine/HitResult.h"
 #include "InputCoreTypes.h"
 #include "SimpleComponent.h"
+#include "SimpleTraceRecorder.h"
 #include "SimpleTraceComponent.generated.h"
 
 class UCameraComponent;
 class USimpleTraceableComponent;
+class USimpleTraceSubsystem;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnFocusChangedDel, USimpleTraceableComponent*, PreviousFocus, USimpleTraceableComponent*, NewFocus);
 
 USTRUCT(BlueprintType)
 struct FSimpleLineTrace
@@ -44,6 +48,12 @@ struct FSimpleLineTrace
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Line Trace", meta=(EditConditionHides, EditCondition = "DebugType != EDrawDebugTrace::None", ToolTip="Debug line draw time duration."))
 	float DrawTime = 5.0f;
+
+	/** @return True if both settings describe the same trace query. Debug drawing settings are not compared. */
+	bool HasSameQuery(const FSimpleLineTrace& Other) const;
+
+	/** @return Query params set up the way UKismetSystemLibrary::LineTraceSingleForObjects sets them up, without ignored actors. */
+	static FCollisionQueryParams MakeQueryParams(bool bInTraceComplex);
 	
 };
 
@@ -52,6 +62,8 @@ class SIMPLEINTERACTIONSYSTEM_API USimpleTraceComponent : public USimpleComponen
 {
 	GENERATED_BODY()
 
+	friend class USimpleTraceSubsystem;
+
 public:
 	// Sets default values for this component's properties
 	USimpleTraceComponent();
@@ -60,6 +72,9 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -78,6 +93,9 @@ public:
 	
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Interaction", meta=(EditConditionHides, EditCondition = "bEnableController == true", ToolTip="Controller key for interaction."))
 	FKey ControllerInteractionKey = FKey(EKeys::Gamepad_FaceButton_Top);
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Recording", meta=(ToolTip="Record camera, trace settings, hits and interaction keys for offline replay. Can also be enabled with -SimpleTraceRecord."))
+	bool bRecordSession = false;
 	
 	//Delegates
 	UPROPERTY(BlueprintAssignable, Category="Delegates")
@@ -91,6 +109,12 @@ public:
 	
 	UPROPERTY(BlueprintAssignable, Category="Delegates")
 	FOnStopHitDel OnStopHitDel;
+
+	UPROPERTY(BlueprintAssignable, Category="Delegates", meta=(ToolTip="Fires only when the focused traceable component changes, unlike OnHitDel which fires every frame."))
+	FOnFocusChangedDel OnFocusChangedDel;
+
+	UFUNCTION(BlueprintPure, Category="Interaction")
+	USimpleTraceableComponent* GetFocusedComponent() const;
 	
 private:
 	
@@ -106,6 +130,11 @@ private:
 	UPROPERTY()
 	bool bCanTrace = true;
 
+	UPROPERTY()
+	USimpleTraceSubsystem* TraceSubsystem = nullptr;
+
+	TUniquePtr<FSimpleTraceRecorder> Recorder;
+
 	void SetKeyBinds();
 	void PerformChecks();
 	void BindKeys(const FKey& InteractionKey);
@@ -118,6 +147,9 @@ private:
 	void OnCantTrace();
 	void BroadcastAndExecuteOnExit();
 	void OnCanTrace();
+	void StartRecording();
+	void RecordFrame(float DeltaTime);
 	USimpleTraceableComponent* GetSimpleTraceableComponent() const;
+	FVector GetStartTraceLocation() const;
 	FVector GetEndTraceLocation() const;
 };
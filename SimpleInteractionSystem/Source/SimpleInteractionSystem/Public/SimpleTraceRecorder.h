@@ -0,0 +1,94 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+struct FSimpleLineTrace;
+
+/** Per-frame flags stored in front of every frame record. */
+enum class ESimpleTraceFrameFlags : uint8
+{
+	None = 0,
+	Hit = 1 << 0,
+	InteractionPressed = 1 << 1,
+	InteractionReleased = 1 << 2,
+	SettingsChanged = 1 << 3,
+};
+ENUM_CLASS_FLAGS(ESimpleTraceFrameFlags);
+
+/**
+ * The parts of FSimpleLineTrace that affect the trace query. Only written when they change.
+ * bIgnoreSelf is not recorded since the recording owner does not exist on replay.
+ */
+struct SIMPLEINTERACTIONSYSTEM_API FSimpleTraceSettingsRecord
+{
+	double TraceDistance = 0.0;
+	TArray<uint8> ObjectTypes;
+	bool bTraceComplex = true;
+	TArray<FString> ActorsToIgnore;
+
+	FSimpleTraceSettingsRecord() = default;
+	explicit FSimpleTraceSettingsRecord(const FSimpleLineTrace& LineTrace);
+
+	friend FArchive& operator<<(FArchive& Ar, FSimpleTraceSettingsRecord& Settings);
+};
+
+/** A single recorded frame. Hit data is only serialized when the Hit flag is set. */
+struct SIMPLEINTERACTIONSYSTEM_API FSimpleTraceFrameRecord
+{
+	ESimpleTraceFrameFlags Flags = ESimpleTraceFrameFlags::None;
+	float DeltaTime = 0.0f;
+	FVector3f CameraLocation = FVector3f::ZeroVector;
+	FRotator3f CameraRotation = FRotator3f::ZeroRotator;
+	FVector3f ImpactPoint = FVector3f::ZeroVector;
+	FName HitActor;
+};
+
+/**
+ * Streams the per-frame state of a USimpleTraceComponent into a compact binary file.
+ *
+ * Layout: magic, version, map name, then one frame record per tick. Hit actor names are written once
+ * and referenced by index afterwards.
+ */
+class SIMPLEINTERACTIONSYSTEM_API FSimpleTraceRecorder
+{
+public:
+	static constexpr uint32 Magic = 0x52544953; // 'SITR'
+	static constexpr uint32 Version = 3;
+
+	FSimpleTraceRecorder(const FString& FilePath, const FString& MapName);
+	~FSimpleTraceRecorder();
+
+	bool IsValid() const;
+
+	void RecordInteractionKey(bool bPressed);
+	void RecordFrame(float DeltaTime, const FVector& CameraLocation, const FRotator& CameraRotation, const FSimpleLineTrace& LineTrace, const FHitResult& HitResult);
+
+private:
+	TUniquePtr<FArchive> Writer;
+	TMap<FName, int32> NameTable;
+	TUniquePtr<FSimpleLineTrace> LastLineTrace;
+	ESimpleTraceFrameFlags PendingFlags = ESimpleTraceFrameFlags::None;
+};
+
+/** Reads a stream written by FSimpleTraceRecorder frame by frame. */
+class SIMPLEINTERACTIONSYSTEM_API FSimpleTraceRecordingReader
+{
+public:
+	bool Open(const FString& InFilePath);
+	const FString& GetMapName() const;
+
+	/**
+	 * @param OutFrame The next frame.
+	 * @param InOutSettings Updated in place when the frame carries new settings.
+	 * @return False at the end of the stream or on a corrupt record.
+	 */
+	bool ReadFrame(FSimpleTraceFrameRecord& OutFrame, FSimpleTraceSettingsRecord& InOutSettings);
+
+private:
+	TUniquePtr<FArchive> Reader;
+	TArray<FName> NameTable;
+	FString MapName;
+};
@@ -0,0 +1,31 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SimpleTraceReplayCommandlet.generated.h"
+
+class UWorld;
+
+/**
+ * Replays a trace recording headlessly against a map and reports trace cost and event counts.
+ *
+ * Usage: -run=SimpleTraceReplay -Recording=<file.sitrace> [-Map=<package>] [-TraceMode=Single|Multi]
+ *        [-TraceDistance=<cm>] [-TraceComplex=<bool>] -nullrhi
+ */
+UCLASS()
+class SIMPLEINTERACTIONSYSTEM_API USimpleTraceReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USimpleTraceReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	static UWorld* LoadWorld(const FString& MapName);
+	static bool LoadStreamingLevels(UWorld* World);
+	static void UnloadWorld(UWorld* World);
+};
@@ -0,0 +1,89 @@
+// Copyright 2023 Georgios Lazaridis. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "SimpleTraceComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SimpleTraceSubsystem.generated.h"
+
+class AActor;
+class UCameraComponent;
+
+/**
+ * Coalesces the traces of USimpleTraceComponents that share a camera, ray length and query settings.
+ *
+ * Each group runs one multi trace per frame against the merged object types of its members.
+ * The hits are then demultiplexed so every member sees the closest hit matching its own object types,
+ * which is what its own single trace would have returned.
+ *
+ * Groups are only rebuilt when components register, unregister or change their trace settings.
+ */
+UCLASS()
+class SIMPLEINTERACTIONSYSTEM_API USimpleTraceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterTraceComponent(USimpleTraceComponent* TraceComponent);
+	void UnregisterTraceComponent(USimpleTraceComponent* TraceComponent);
+
+	/**
+	 * @param TraceComponent The component asking for its trace.
+	 * @param Start The trace start location.
+	 * @param End The trace end location.
+	 * @param OutHit The closest hit matching the component's object types.
+	 * @param bOutHit True if something was hit.
+	 * @return False if the component is not part of a group and has to trace on its own.
+	 */
+	bool TraceCoalesced(const USimpleTraceComponent* TraceComponent, const FVector& Start, const FVector& End, FHitResult& OutHit, bool& bOutHit);
+
+private:
+	struct FTraceGroup
+	{
+		const UCameraComponent* Camera = nullptr;
+		double TraceDistance = 0.0;
+		bool bTraceComplex = true;
+		const AActor* IgnoredOwner = nullptr;
+		TArray<AActor*> ActorsToIgnore;
+		int32 ObjectTypesToQuery = 0;
+		int32 NumMembers = 0;
+
+		uint64 TraceFrame = MAX_uint64;
+		FVector TraceStart = FVector::ZeroVector;
+		FVector TraceEnd = FVector::ZeroVector;
+		TArray<FHitResult> Hits;
+	};
+
+	struct FGroupMember
+	{
+		int32 GroupIndex = INDEX_NONE;
+		int32 ObjectTypesToQuery = 0;
+	};
+
+	/** The settings a component was grouped with, used to detect runtime changes without rebuilding. */
+	struct FGroupedSettings
+	{
+		const UCameraComponent* Camera = nullptr;
+		FSimpleLineTrace LineTrace;
+	};
+
+	UPROPERTY()
+	TArray<USimpleTraceComponent*> TraceComponents;
+
+	TArray<FTraceGroup> Groups;
+
+	TMap<const USimpleTraceComponent*, FGroupMember> Members;
+
+	TArray<FGroupedSettings> GroupedSettings;
+
+	uint64 CheckedFrame = MAX_uint64;
+
+	bool bGroupsDirty = true;
+
+	bool HaveSettingsChanged() const;
+	void RebuildGroups();
+	static bool CanCoalesce(const USimpleTraceComponent* TraceComponent);
+	static bool BelongsToGroup(const FTraceGroup& Group, const USimpleTraceComponent* TraceComponent);
+};
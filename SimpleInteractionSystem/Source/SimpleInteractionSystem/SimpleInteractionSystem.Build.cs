@@ -27,6 +27,7 @@ public class SimpleInteractionSystem : ModuleRules
 			{
 				"Core",
 				"Engine",
+				"UMG",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);